@@ -1,6 +1,8 @@
 #include "provided.h"
+#include "DeliveryPlanning.h"
 #include <vector>
 #include <ctime>
+#include <utility>
 using namespace std;
 
 class DeliveryOptimizerImpl
@@ -115,3 +117,79 @@ void DeliveryOptimizer::optimizeDeliveryOrder(
 {
     return m_impl->optimizeDeliveryOrder(depot, deliveries, oldCrowDistance, newCrowDistance);
 }
+
+//******************** Incremental insertion **********************************
+
+// The i-th stop of a trip from start through deliveries back to depot
+static const GeoCoord& stop(const GeoCoord& start, const GeoCoord& depot, const vector<DeliveryRequest>& deliveries, int i)
+{
+    if (i < 0)
+        return start;
+    if (i >= deliveries.size())
+        return depot;
+    return deliveries[i].location;
+}
+
+// Cost of putting location between stops i-1 and i, and the cheapest such i
+static double cheapestInsertion(const GeoCoord& start, const GeoCoord& depot, const vector<DeliveryRequest>& deliveries, const GeoCoord& location, int& best)
+{
+    best = 0;
+    double bestCost = 0;
+    for (int i = 0; i <= deliveries.size(); i++)
+    {
+        const GeoCoord& before = stop(start, depot, deliveries, i - 1);
+        const GeoCoord& after = stop(start, depot, deliveries, i);
+        double cost = distanceEarthMiles(before, location) + distanceEarthMiles(location, after) - distanceEarthMiles(before, after);
+        if (i == 0 || cost < bestCost)
+        {
+            best = i;
+            bestCost = cost;
+        }
+    }
+    return bestCost;
+}
+
+void insertDelivery(
+    const GeoCoord& start,
+    const GeoCoord& depot,
+    vector<DeliveryRequest>& deliveries,
+    const DeliveryRequest& delivery)
+{
+    // Cheapest insertion: put the delivery where it adds the least crow distance
+    int added;
+    cheapestInsertion(start, depot, deliveries, delivery.location, added);
+    deliveries.insert(deliveries.begin() + added, delivery);
+    
+    // Local repair (Or-opt): the new stop may leave a neighbour better placed
+    // somewhere else, so move the neighbours while that shortens the route
+    bool improved = true;
+    while (improved)
+    {
+        improved = false;
+        for (int i = added - 1; i <= added + 1; i += 2)
+        {
+            if (i < 0 || i >= deliveries.size())
+                continue;
+            const GeoCoord& before = stop(start, depot, deliveries, i - 1);
+            const GeoCoord& after = stop(start, depot, deliveries, i + 1);
+            double saved = distanceEarthMiles(before, deliveries[i].location) + distanceEarthMiles(deliveries[i].location, after) - distanceEarthMiles(before, after);
+            
+            vector<DeliveryRequest> rest = deliveries;
+            rest.erase(rest.begin() + i);
+            int to;
+            double cost = cheapestInsertion(start, depot, rest, deliveries[i].location, to);
+            if (cost < saved - 1e-9)
+            {
+                rest.insert(rest.begin() + to, deliveries[i]);
+                deliveries.swap(rest);
+                // Keep track of where the new stop ended up
+                if (i < added && to > added - 1)
+                    added--;
+                else if (i > added && to <= added)
+                    added++;
+                improved = true;
+                break;
+            }
+        }
+    }
+}
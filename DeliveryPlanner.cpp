@@ -1,10 +1,38 @@
 #include "provided.h"
+#include "RouteEncoding.h"
+#include "DeliveryPlanning.h"
 #include <string>
 #include <vector>
 #include <list>
+#include <iterator>
 #include <algorithm>
 using namespace std;
 
+static string dir(double angle)
+{
+    if (angle < 0)
+        return "";
+    if (angle < 22.5)
+        return "east";
+    if (angle < 67.5)
+        return "northeast";
+    if (angle < 112.5)
+        return "north";
+    if (angle < 157.5)
+        return "northwest";
+    if (angle < 202.5)
+        return "west";
+    if (angle < 247.5)
+        return "southwest";
+    if (angle < 292.5)
+        return "south";
+    if (angle < 337.5)
+        return "southeast";
+    if (angle >= 337.5)
+        return "east";
+    return "";
+}
+
 class DeliveryPlannerImpl
 {
 public:
@@ -15,8 +43,12 @@ public:
         const vector<DeliveryRequest>& deliveries,
         vector<DeliveryCommand>& commands,
         double& totalDistanceTravelled) const;
+    DeliveryResult generateDeliveryLegs(
+        const GeoCoord& depot,
+        vector<DeliveryRequest>& optimizedDeliveries,
+        vector<list<StreetSegment> >& paths,
+        double& totalDistanceTravelled) const;
 private:
-    string dir(double angle) const;
     const StreetMap* sm;
 };
 
@@ -32,22 +64,41 @@ DeliveryResult DeliveryPlannerImpl::generateDeliveryPlan(
     double& totalDistanceTravelled) const
 {
     
+    vector<DeliveryRequest> optimizedDeliveries = deliveries;
+    vector<list<StreetSegment> > paths;
+    
+    if (deliveries.empty())
+        return DELIVERY_SUCCESS;
+    
+    DeliveryResult result = generateDeliveryLegs(depot, optimizedDeliveries, paths, totalDistanceTravelled);
+    if (result != DELIVERY_SUCCESS)
+        return result;
+    
+    generateDeliveryCommands(optimizedDeliveries, paths, commands);
+    return DELIVERY_SUCCESS;
+}
+
+DeliveryResult DeliveryPlannerImpl::generateDeliveryLegs(
+    const GeoCoord& depot,
+    vector<DeliveryRequest>& optimizedDeliveries,
+    vector<list<StreetSegment> >& paths,
+    double& totalDistanceTravelled) const
+{
+    
     // Optimize route
-    vector<DeliveryRequest> optimizedDeliveries;
-    optimizedDeliveries = deliveries;
     DeliveryOptimizer optimizer(sm);
     double oldCrow, newCrow;
     optimizer.optimizeDeliveryOrder(depot, optimizedDeliveries, oldCrow, newCrow);
     
     PointToPointRouter router(sm);
-    vector<list<StreetSegment> > paths = vector<list<StreetSegment> >(optimizedDeliveries.size() + 1);
+    paths = vector<list<StreetSegment> >(optimizedDeliveries.size() + 1);
+    
+    if (optimizedDeliveries.empty())
+        return DELIVERY_SUCCESS;
     
     // Start from depot
     GeoCoord current = depot;
     
-    if (deliveries.empty())
-        return DELIVERY_SUCCESS;
-    
     // Generate street segments
     for (int i = 0; i < optimizedDeliveries.size(); i++)
     {
@@ -67,10 +118,48 @@ DeliveryResult DeliveryPlannerImpl::generateDeliveryPlan(
     }
     
     // Return path
-    double distance;
-    router.generatePointToPointRoute(optimizedDeliveries[optimizedDeliveries.size() - 1].location, depot, paths[optimizedDeliveries.size()], distance);
+    double distance = 0;
+    DeliveryResult generate = router.generatePointToPointRoute(current, depot, paths[optimizedDeliveries.size()], distance);
+    if (generate != DELIVERY_SUCCESS)
+        return generate;
     totalDistanceTravelled += distance;
     
+    return DELIVERY_SUCCESS;
+}
+
+//******************** DeliveryPlanner functions ******************************
+
+// These functions simply delegate to DeliveryPlannerImpl's functions.
+// You probably don't want to change any of this code.
+
+DeliveryPlanner::DeliveryPlanner(const StreetMap* sm)
+{
+    m_impl = new DeliveryPlannerImpl(sm);
+}
+
+DeliveryPlanner::~DeliveryPlanner()
+{
+    delete m_impl;
+}
+
+DeliveryResult DeliveryPlanner::generateDeliveryPlan(
+    const GeoCoord& depot,
+    const vector<DeliveryRequest>& deliveries,
+    vector<DeliveryCommand>& commands,
+    double& totalDistanceTravelled) const
+{
+    return m_impl->generateDeliveryPlan(depot, deliveries, commands, totalDistanceTravelled);
+}
+
+//******************** Delivery commands **************************************
+
+void generateDeliveryCommands(
+    const vector<DeliveryRequest>& optimizedDeliveries,
+    const vector<list<StreetSegment> >& paths,
+    vector<DeliveryCommand>& commands)
+{
+    double distance;
+    
     // Turn segments into commands
     for (int i = 0; i < paths.size(); i++)
     {
@@ -102,7 +191,7 @@ DeliveryResult DeliveryPlannerImpl::generateDeliveryPlan(
                 distance = 0;
                 
                 // Check for turns
-                double turn = angleBetween2Lines(*(--it), *(++it));
+                double turn = angleBetween2Lines(*prev(it), *it);
                 if (turn >= 1 && turn < 180)
                 {
                     DeliveryCommand dt;
@@ -128,56 +217,45 @@ DeliveryResult DeliveryPlannerImpl::generateDeliveryPlan(
             commands.push_back(dv);
         }
     }
-    
-    
-    return DELIVERY_SUCCESS;
-}
-
-string DeliveryPlannerImpl::dir(double angle) const
-{
-    if (angle < 0)
-        return "";
-    if (angle < 22.5)
-        return "east";
-    if (angle < 67.5)
-        return "northeast";
-    if (angle < 112.5)
-        return "north";
-    if (angle < 157.5)
-        return "northwest";
-    if (angle < 202.5)
-        return "west";
-    if (angle < 247.5)
-        return "southwest";
-    if (angle < 292.5)
-        return "south";
-    if (angle < 337.5)
-        return "southeast";
-    if (angle >= 337.5)
-        return "east";
-    return "";
 }
 
-//******************** DeliveryPlanner functions ******************************
+//******************** Encoded delivery plans *********************************
 
-// These functions simply delegate to DeliveryPlannerImpl's functions.
-// You probably don't want to change any of this code.
-
-DeliveryPlanner::DeliveryPlanner(const StreetMap* sm)
-{
-    m_impl = new DeliveryPlannerImpl(sm);
-}
-
-DeliveryPlanner::~DeliveryPlanner()
-{
-    delete m_impl;
-}
-
-DeliveryResult DeliveryPlanner::generateDeliveryPlan(
+DeliveryResult generateEncodedDeliveryPlan(
+    const StreetMap* sm,
     const GeoCoord& depot,
     const vector<DeliveryRequest>& deliveries,
-    vector<DeliveryCommand>& commands,
-    double& totalDistanceTravelled) const
+    vector<DeliveryRequest>& orderedDeliveries,
+    vector<string>& encodedLegs,
+    double& totalDistanceTravelled)
 {
-    return m_impl->generateDeliveryPlan(depot, deliveries, commands, totalDistanceTravelled);
+    DeliveryPlannerImpl planner(sm);
+    vector<DeliveryRequest> optimizedDeliveries = deliveries;
+    vector<list<StreetSegment> > paths;
+    
+    if (deliveries.empty())
+    {
+        orderedDeliveries.clear();
+        encodedLegs.clear();
+        return DELIVERY_SUCCESS;
+    }
+    
+    double distance = 0;
+    DeliveryResult result = planner.generateDeliveryLegs(depot, optimizedDeliveries, paths, distance);
+    if (result != DELIVERY_SUCCESS)
+        return result;
+    
+    // Encode each leg and release its expanded segments. Routed legs are
+    // contiguous, which is all encodeRoute needs.
+    vector<string> legs(paths.size());
+    for (int i = 0; i < paths.size(); i++)
+    {
+        encodeRoute(paths[i], legs[i]);
+        list<StreetSegment>().swap(paths[i]);
+    }
+    
+    orderedDeliveries.swap(optimizedDeliveries);
+    encodedLegs.swap(legs);
+    totalDistanceTravelled += distance;
+    return DELIVERY_SUCCESS;
 }
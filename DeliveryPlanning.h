@@ -0,0 +1,45 @@
+#ifndef DELIVERY_PLANNING
+#define DELIVERY_PLANNING
+
+#include "provided.h"
+#include <string>
+#include <vector>
+#include <list>
+
+// DeliveryPlanning.h
+
+// Planning steps that DeliveryReplanner (and generateEncodedDeliveryPlan) need
+// but that aren't part of the classes in provided.h, whose interfaces are
+// fixed.
+
+// Appends the proceed/turn/deliver commands for routed legs to commands.
+// Defined in DeliveryPlanner.cpp.
+void generateDeliveryCommands(
+    const std::vector<DeliveryRequest>& deliveries,
+    const std::vector<std::list<StreetSegment> >& paths,
+    std::vector<DeliveryCommand>& commands);
+
+// Cheapest insertion of delivery into a trip from start through deliveries
+// and back to depot, followed by a local repair around the new stop.
+// Defined in DeliveryOptimizer.cpp.
+void insertDelivery(
+    const GeoCoord& start,
+    const GeoCoord& depot,
+    std::vector<DeliveryRequest>& deliveries,
+    const DeliveryRequest& delivery);
+
+// Same as DeliveryPlanner::generateDeliveryPlan, but instead of commands it
+// produces the optimized delivery order and one encodeRoute string per leg
+// (depot to the first delivery, ..., last delivery back to the depot).
+// Returns BAD_COORD if a coordinate isn't on the map and NO_ROUTE if a
+// delivery can't be reached; the outputs are then left unchanged.
+// Defined in DeliveryPlanner.cpp.
+DeliveryResult generateEncodedDeliveryPlan(
+    const StreetMap* sm,
+    const GeoCoord& depot,
+    const std::vector<DeliveryRequest>& deliveries,
+    std::vector<DeliveryRequest>& orderedDeliveries,
+    std::vector<std::string>& encodedLegs,
+    double& totalDistanceTravelled);
+
+#endif
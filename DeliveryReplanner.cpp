@@ -0,0 +1,265 @@
+#include "provided.h"
+#include "DeliveryReplanner.h"
+#include "DeliveryPlanning.h"
+#include <string>
+#include <vector>
+#include <list>
+using namespace std;
+
+class DeliveryReplannerImpl
+{
+public:
+    DeliveryReplannerImpl(const StreetMap* sm);
+    ~DeliveryReplannerImpl();
+    DeliveryResult generateDeliveryPlan(
+        const GeoCoord& depot,
+        const vector<DeliveryRequest>& deliveries,
+        vector<DeliveryCommand>& commands,
+        double& totalDistanceTravelled);
+    DeliveryResult addDelivery(
+        const GeoCoord& courierPosition,
+        const DeliveryRequest& delivery,
+        vector<DeliveryCommand>& commands,
+        double& totalDistanceTravelled);
+    DeliveryResult cancelDelivery(
+        const GeoCoord& courierPosition,
+        const DeliveryRequest& delivery,
+        vector<DeliveryCommand>& commands,
+        double& totalDistanceTravelled,
+        bool& wasInPlan);
+    int routesGenerated() const;
+    bool hasPlan() const;
+private:
+    void moveCourier(const GeoCoord& courierPosition);
+    DeliveryResult replan(
+        const GeoCoord& depot,
+        const GeoCoord& courierPosition,
+        const vector<DeliveryRequest>& deliveries,
+        vector<DeliveryCommand>& commands,
+        double& totalDistanceTravelled);
+    void describe(vector<DeliveryCommand>& commands, double& totalDistanceTravelled) const;
+    const StreetMap* sm;
+    PointToPointRouter m_router;
+
+    // The plan: m_paths[0] goes from m_start to the first delivery, m_paths[i]
+    // from delivery i-1 to delivery i, and the last one back to m_depot
+    GeoCoord m_depot;
+    GeoCoord m_start;
+    vector<DeliveryRequest> m_deliveries;
+    vector<list<StreetSegment> > m_paths;
+    bool m_planned = false;
+
+    int m_routes = 0;
+};
+
+DeliveryReplannerImpl::DeliveryReplannerImpl(const StreetMap* sm) : sm(sm), m_router(sm) {}
+
+DeliveryReplannerImpl::~DeliveryReplannerImpl()
+{}
+
+DeliveryResult DeliveryReplannerImpl::generateDeliveryPlan(
+    const GeoCoord& depot,
+    const vector<DeliveryRequest>& deliveries,
+    vector<DeliveryCommand>& commands,
+    double& totalDistanceTravelled)
+{
+    m_routes = 0;
+    vector<DeliveryRequest> optimizedDeliveries = deliveries;
+    DeliveryOptimizer optimizer(sm);
+    double oldCrow, newCrow;
+    optimizer.optimizeDeliveryOrder(depot, optimizedDeliveries, oldCrow, newCrow);
+    DeliveryResult result = replan(depot, depot, optimizedDeliveries, commands, totalDistanceTravelled);
+    if (result == DELIVERY_SUCCESS)
+        m_planned = true;
+    return result;
+}
+
+DeliveryResult DeliveryReplannerImpl::addDelivery(
+    const GeoCoord& courierPosition,
+    const DeliveryRequest& delivery,
+    vector<DeliveryCommand>& commands,
+    double& totalDistanceTravelled)
+{
+    m_routes = 0;
+    // Nothing to add to, and no depot to return to
+    if (!m_planned)
+        return NO_ROUTE;
+    moveCourier(courierPosition);
+    vector<DeliveryRequest> deliveries = m_deliveries;
+    insertDelivery(courierPosition, m_depot, deliveries, delivery);
+    return replan(m_depot, courierPosition, deliveries, commands, totalDistanceTravelled);
+}
+
+DeliveryResult DeliveryReplannerImpl::cancelDelivery(
+    const GeoCoord& courierPosition,
+    const DeliveryRequest& delivery,
+    vector<DeliveryCommand>& commands,
+    double& totalDistanceTravelled,
+    bool& wasInPlan)
+{
+    m_routes = 0;
+    if (!m_planned)
+    {
+        wasInPlan = false;
+        return DELIVERY_SUCCESS;
+    }
+    vector<DeliveryRequest> deliveries = m_deliveries;
+    auto it = deliveries.begin();
+    for (; it != deliveries.end(); it++)
+    {
+        if (it->item == delivery.item && it->location == delivery.location)
+            break;
+    }
+    wasInPlan = (it != deliveries.end());
+    if (!wasInPlan)
+        return DELIVERY_SUCCESS;
+    deliveries.erase(it);
+    moveCourier(courierPosition);
+    return replan(m_depot, courierPosition, deliveries, commands, totalDistanceTravelled);
+}
+
+int DeliveryReplannerImpl::routesGenerated() const
+{
+    return m_routes;
+}
+
+bool DeliveryReplannerImpl::hasPlan() const
+{
+    return m_planned;
+}
+
+// PRIVATE FUNCTIONS
+
+void DeliveryReplannerImpl::moveCourier(const GeoCoord& courierPosition)
+{
+    if (courierPosition == m_start || m_paths.empty())
+        return;
+
+    // If the courier is somewhere along the first leg, keep the rest of it
+    list<StreetSegment>& first = m_paths[0];
+    for (auto it = first.begin(); it != first.end(); it++)
+    {
+        if (it->start == courierPosition)
+        {
+            first.erase(first.begin(), it);
+            m_start = courierPosition;
+            return;
+        }
+    }
+    if (!first.empty() && first.back().end == courierPosition)
+    {
+        first.clear();
+        m_start = courierPosition;
+    }
+}
+
+DeliveryResult DeliveryReplannerImpl::replan(
+    const GeoCoord& depot,
+    const GeoCoord& courierPosition,
+    const vector<DeliveryRequest>& deliveries,
+    vector<DeliveryCommand>& commands,
+    double& totalDistanceTravelled)
+{
+    vector<list<StreetSegment> > paths(deliveries.size() + 1);
+    for (int i = 0; i < paths.size(); i++)
+    {
+        const GeoCoord& from = (i == 0) ? courierPosition : deliveries[i - 1].location;
+        const GeoCoord& to = (i == deliveries.size()) ? depot : deliveries[i].location;
+        if (from == to)
+            continue;
+
+        // Reuse the old leg between the same two points, if there was one
+        int j = 0;
+        for (; j < m_paths.size(); j++)
+        {
+            const GeoCoord& oldFrom = (j == 0) ? m_start : m_deliveries[j - 1].location;
+            const GeoCoord& oldTo = (j == m_deliveries.size()) ? m_depot : m_deliveries[j].location;
+            if (oldFrom == from && oldTo == to)
+                break;
+        }
+        if (j != m_paths.size())
+        {
+            paths[i] = m_paths[j];
+            continue;
+        }
+
+        double distance = 0;
+        m_routes++;
+        DeliveryResult generate = m_router.generatePointToPointRoute(from, to, paths[i], distance);
+        if (generate != DELIVERY_SUCCESS)
+            return generate;
+    }
+
+    m_depot = depot;
+    m_start = courierPosition;
+    m_deliveries = deliveries;
+    m_paths.swap(paths);
+    describe(commands, totalDistanceTravelled);
+    return DELIVERY_SUCCESS;
+}
+
+// Unlike DeliveryPlanner, commands and totalDistanceTravelled are replaced
+// rather than added to, since each call describes the whole remaining trip
+void DeliveryReplannerImpl::describe(vector<DeliveryCommand>& commands, double& totalDistanceTravelled) const
+{
+    commands.clear();
+    generateDeliveryCommands(m_deliveries, m_paths, commands);
+    totalDistanceTravelled = 0;
+    for (int i = 0; i < m_paths.size(); i++)
+    {
+        for (auto it = m_paths[i].begin(); it != m_paths[i].end(); it++)
+            totalDistanceTravelled += distanceEarthMiles(it->start, it->end);
+    }
+}
+
+//******************** DeliveryReplanner functions ****************************
+
+// These functions simply delegate to DeliveryReplannerImpl's functions.
+
+DeliveryReplanner::DeliveryReplanner(const StreetMap* sm)
+{
+    m_impl = new DeliveryReplannerImpl(sm);
+}
+
+DeliveryReplanner::~DeliveryReplanner()
+{
+    delete m_impl;
+}
+
+DeliveryResult DeliveryReplanner::generateDeliveryPlan(
+    const GeoCoord& depot,
+    const vector<DeliveryRequest>& deliveries,
+    vector<DeliveryCommand>& commands,
+    double& totalDistanceTravelled)
+{
+    return m_impl->generateDeliveryPlan(depot, deliveries, commands, totalDistanceTravelled);
+}
+
+DeliveryResult DeliveryReplanner::addDelivery(
+    const GeoCoord& courierPosition,
+    const DeliveryRequest& delivery,
+    vector<DeliveryCommand>& commands,
+    double& totalDistanceTravelled)
+{
+    return m_impl->addDelivery(courierPosition, delivery, commands, totalDistanceTravelled);
+}
+
+DeliveryResult DeliveryReplanner::cancelDelivery(
+    const GeoCoord& courierPosition,
+    const DeliveryRequest& delivery,
+    vector<DeliveryCommand>& commands,
+    double& totalDistanceTravelled,
+    bool& wasInPlan)
+{
+    return m_impl->cancelDelivery(courierPosition, delivery, commands, totalDistanceTravelled, wasInPlan);
+}
+
+int DeliveryReplanner::routesGenerated() const
+{
+    return m_impl->routesGenerated();
+}
+
+bool DeliveryReplanner::hasPlan() const
+{
+    return m_impl->hasPlan();
+}
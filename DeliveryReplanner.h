@@ -0,0 +1,75 @@
+#ifndef DELIVERY_REPLANNER
+#define DELIVERY_REPLANNER
+
+#include "provided.h"
+#include <string>
+#include <vector>
+#include <list>
+
+// DeliveryReplanner.h
+
+class DeliveryReplannerImpl;
+
+// Keeps a courier's delivery plan (the remaining deliveries in order and the
+// routed leg to each of them) so orders can be added or cancelled mid-route
+// without re-optimizing and re-routing the whole batch. Only legs whose end
+// points change are routed again; the rest are reused.
+//
+// Every call describes the whole remaining trip: unlike DeliveryPlanner,
+// commands is cleared before the new commands are added, and
+// totalDistanceTravelled is set rather than added to.
+//
+// generateDeliveryPlan must succeed before deliveries can be added or
+// cancelled (see hasPlan); until then there is no depot to return to.
+class DeliveryReplanner
+{
+public:
+    DeliveryReplanner(const StreetMap* sm);
+    ~DeliveryReplanner();
+
+      // Plans from scratch (optimizing the order and routing every leg) and
+      // keeps the plan for later updates
+    DeliveryResult generateDeliveryPlan(
+        const GeoCoord& depot,
+        const std::vector<DeliveryRequest>& deliveries,
+        std::vector<DeliveryCommand>& commands,
+        double& totalDistanceTravelled);
+
+      // Adds a delivery to the plan for a courier now at courierPosition (an
+      // intersection on the map). commands and totalDistanceTravelled
+      // describe the rest of the trip from there. Returns NO_ROUTE, leaving
+      // the outputs unchanged, if there is no plan yet.
+    DeliveryResult addDelivery(
+        const GeoCoord& courierPosition,
+        const DeliveryRequest& delivery,
+        std::vector<DeliveryCommand>& commands,
+        double& totalDistanceTravelled);
+
+      // Drops a delivery (cancelled, or already delivered) from the plan.
+      // wasInPlan is set to false if no such delivery is in the plan (or
+      // there is no plan yet); the plan and the other outputs are then left
+      // unchanged.
+    DeliveryResult cancelDelivery(
+        const GeoCoord& courierPosition,
+        const DeliveryRequest& delivery,
+        std::vector<DeliveryCommand>& commands,
+        double& totalDistanceTravelled,
+        bool& wasInPlan);
+
+      // Number of point-to-point routes actually computed by the last call,
+      // including a failed one
+    int routesGenerated() const;
+
+      // Whether generateDeliveryPlan has succeeded, so there is a plan to
+      // add deliveries to or cancel them from
+    bool hasPlan() const;
+
+      // C++11 syntax for preventing copying and assignment
+    DeliveryReplanner(const DeliveryReplanner&) = delete;
+    DeliveryReplanner& operator=(const DeliveryReplanner&) = delete;
+
+private:
+    DeliveryReplannerImpl* m_impl;
+};
+
+#endif
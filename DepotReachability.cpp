@@ -0,0 +1,212 @@
+#include "provided.h"
+#include "DepotReachability.h"
+#include "StreetMapGraph.h"
+#include <vector>
+#include <queue>
+#include <map>
+#include <limits>
+#include <functional>
+using namespace std;
+
+class DepotReachabilityImpl
+{
+public:
+    DepotReachabilityImpl(const StreetMap* sm);
+    ~DepotReachabilityImpl();
+    DeliveryResult reachableIntersections(
+        const GeoCoord& depot,
+        double maxMiles,
+        vector<GeoCoord>& reachable,
+        vector<double>& distances) const;
+    DeliveryResult addressesWithin(
+        const GeoCoord& depot,
+        const vector<GeoCoord>& addresses,
+        double maxMiles,
+        vector<bool>& within,
+        vector<double>& distances) const;
+private:
+    // (distance, intersection index), smallest distance on top
+    typedef pair<double,int> queuedNode;
+    int nodeId(const GeoCoord& coord) const;
+    void search(
+        int depot,
+        double maxMiles,
+        const vector<bool>* targets,
+        int targetCount,
+        vector<int>& settled,
+        vector<double>& distances) const;
+    const StreetMapGraph* m_graph;
+};
+
+DepotReachabilityImpl::DepotReachabilityImpl(const StreetMap* sm) : m_graph(streetMapGraph(sm))
+{
+}
+
+DepotReachabilityImpl::~DepotReachabilityImpl()
+{
+}
+
+DeliveryResult DepotReachabilityImpl::reachableIntersections(
+    const GeoCoord& depot,
+    double maxMiles,
+    vector<GeoCoord>& reachable,
+    vector<double>& distances) const
+{
+    int start = nodeId(depot);
+    if (start == -1)
+        return BAD_COORD;
+    
+    vector<int> settled;
+    vector<double> settledDistances;
+    search(start, maxMiles, nullptr, 0, settled, settledDistances);
+    
+    vector<GeoCoord> coords;
+    coords.reserve(settled.size());
+    for (int i = 0; i != settled.size(); i++)
+        coords.push_back(m_graph->nodes[settled[i]]);
+    reachable.swap(coords);
+    distances.swap(settledDistances);
+    return DELIVERY_SUCCESS;
+}
+
+DeliveryResult DepotReachabilityImpl::addressesWithin(
+    const GeoCoord& depot,
+    const vector<GeoCoord>& addresses,
+    double maxMiles,
+    vector<bool>& within,
+    vector<double>& distances) const
+{
+    int start = nodeId(depot);
+    if (start == -1)
+        return BAD_COORD;
+    
+    // Intersections to look for -> positions in addresses. Addresses that
+    // aren't on the map can't be reached, and would keep the search from
+    // stopping early, so they're left out.
+    map<int,vector<int> > positions;
+    vector<bool> targets(m_graph->nodes.size(), false);
+    for (int i = 0; i != addresses.size(); i++)
+    {
+        int node = nodeId(addresses[i]);
+        if (node == -1)
+            continue;
+        positions[node].push_back(i);
+        targets[node] = true;
+    }
+    
+    vector<int> settled;
+    vector<double> settledDistances;
+    if (!positions.empty())
+        search(start, maxMiles, &targets, positions.size(), settled, settledDistances);
+    
+    // The search only returns the targets it reached
+    within = vector<bool>(addresses.size(), false);
+    distances = vector<double>(addresses.size(), 0);
+    for (int i = 0; i != settled.size(); i++)
+    {
+        const vector<int>& found = positions[settled[i]];
+        for (int j = 0; j != found.size(); j++)
+        {
+            within[found[j]] = true;
+            distances[found[j]] = settledDistances[i];
+        }
+    }
+    return DELIVERY_SUCCESS;
+}
+
+// PRIVATE FUNCTIONS
+
+int DepotReachabilityImpl::nodeId(const GeoCoord& coord) const
+{
+    return (m_graph == nullptr) ? -1 : m_graph->nodeId(coord);
+}
+
+// Dijkstra from depot that stops once the next closest intersection is more
+// than maxMiles away, or once all targets have been reached. If targets isn't
+// null only targets are reported, otherwise every intersection reached is.
+void DepotReachabilityImpl::search(
+    int depot,
+    double maxMiles,
+    const vector<bool>* targets,
+    int targetCount,
+    vector<int>& settled,
+    vector<double>& distances) const
+{
+    if (maxMiles < 0)
+        return;
+    
+    // Best distance found so far for each intersection
+    vector<double> best(m_graph->nodes.size(), numeric_limits<double>::infinity());
+    vector<bool> done(m_graph->nodes.size(), false);
+    priority_queue<queuedNode,vector<queuedNode>,greater<queuedNode> > openList;
+    best[depot] = 0;
+    openList.push(queuedNode(0, depot));
+    
+    while (!openList.empty())
+    {
+        double distance = openList.top().first;
+        int current = openList.top().second;
+        openList.pop();
+        if (distance > maxMiles)
+            break;
+        // Skip entries for intersections already settled closer
+        if (done[current])
+            continue;
+        done[current] = true;
+        
+        if (targets == nullptr || (*targets)[current])
+        {
+            settled.push_back(current);
+            distances.push_back(distance);
+            if (targets != nullptr && settled.size() == targetCount)
+                break;
+        }
+        
+        const GeoCoord& from = m_graph->nodes[current];
+        for (int i = m_graph->firstEdge[current]; i != m_graph->firstEdge[current + 1]; i++)
+        {
+            int next = m_graph->edges[i].to;
+            if (done[next])
+                continue;
+            double newDistance = distance + distanceEarthMiles(from, m_graph->nodes[next]);
+            if (newDistance <= maxMiles && newDistance < best[next])
+            {
+                best[next] = newDistance;
+                openList.push(queuedNode(newDistance, next));
+            }
+        }
+    }
+}
+
+//******************** DepotReachability functions ****************************
+
+// These functions simply delegate to DepotReachabilityImpl's functions.
+
+DepotReachability::DepotReachability(const StreetMap* sm)
+{
+    m_impl = new DepotReachabilityImpl(sm);
+}
+
+DepotReachability::~DepotReachability()
+{
+    delete m_impl;
+}
+
+DeliveryResult DepotReachability::reachableIntersections(
+    const GeoCoord& depot,
+    double maxMiles,
+    vector<GeoCoord>& reachable,
+    vector<double>& distances) const
+{
+    return m_impl->reachableIntersections(depot, maxMiles, reachable, distances);
+}
+
+DeliveryResult DepotReachability::addressesWithin(
+    const GeoCoord& depot,
+    const vector<GeoCoord>& addresses,
+    double maxMiles,
+    vector<bool>& within,
+    vector<double>& distances) const
+{
+    return m_impl->addressesWithin(depot, addresses, maxMiles, within, distances);
+}
@@ -0,0 +1,46 @@
+#ifndef DEPOT_REACHABILITY
+#define DEPOT_REACHABILITY
+
+#include "provided.h"
+#include <vector>
+
+// DepotReachability.h
+
+class DepotReachabilityImpl;
+
+// One-to-all road distance queries from a depot. Each query is a single
+// Dijkstra search that stops at the distance budget, so it only touches the
+// part of the map that is actually reachable.
+class DepotReachability
+{
+public:
+    DepotReachability(const StreetMap* sm);
+    ~DepotReachability();
+
+      // Every intersection within maxMiles of road distance from depot, in
+      // order of increasing distance. Returns BAD_COORD if depot isn't on the map.
+    DeliveryResult reachableIntersections(
+        const GeoCoord& depot,
+        double maxMiles,
+        std::vector<GeoCoord>& reachable,
+        std::vector<double>& distances) const;
+
+      // For each address, whether it is within maxMiles of road distance from
+      // depot and if so how far. Addresses not on the map are never within.
+      // Returns BAD_COORD if depot isn't on the map.
+    DeliveryResult addressesWithin(
+        const GeoCoord& depot,
+        const std::vector<GeoCoord>& addresses,
+        double maxMiles,
+        std::vector<bool>& within,
+        std::vector<double>& distances) const;
+
+      // C++11 syntax for preventing copying and assignment
+    DepotReachability(const DepotReachability&) = delete;
+    DepotReachability& operator=(const DepotReachability&) = delete;
+
+private:
+    DepotReachabilityImpl* m_impl;
+};
+
+#endif
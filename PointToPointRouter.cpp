@@ -1,8 +1,10 @@
 #include "provided.h"
+#include "StreetMapGraph.h"
 #include <list>
 #include <queue>
-#include <map>
-#include <set>
+#include <vector>
+#include <limits>
+#include <functional>
 using namespace std;
 
 class PointToPointRouterImpl
@@ -16,27 +18,12 @@ public:
         list<StreetSegment>& route,
         double& totalDistanceTravelled) const;
 private:
-    struct queuedCoord
-    {
-        queuedCoord(GeoCoord coord, double priority) : coord(coord), priority(priority) {}
-        bool operator==(const queuedCoord& rhs) const
-        {
-            return coord == rhs.coord;
-        }
-        GeoCoord coord;
-        double priority;
-    };
-    struct greaterPriority
-    {
-        bool operator()(const queuedCoord& lhs, const queuedCoord& rhs) const
-        {
-            return lhs.priority < rhs.priority;
-        }
-    };
-    const StreetMap* m_map;
+    // (priority, intersection index), smallest priority on top
+    typedef pair<double,int> queuedNode;
+    const StreetMapGraph* m_graph;
 };
 
-PointToPointRouterImpl::PointToPointRouterImpl(const StreetMap* sm) : m_map(sm)
+PointToPointRouterImpl::PointToPointRouterImpl(const StreetMap* sm) : m_graph(streetMapGraph(sm))
 {
 }
 
@@ -50,12 +37,12 @@ DeliveryResult PointToPointRouterImpl::generatePointToPointRoute(
         list<StreetSegment>& route,
         double& totalDistanceTravelled) const
 {
-    vector<StreetSegment> begin;
-    vector<StreetSegment> last;
+    const StreetMapGraph* graph = m_graph;
     
     // Check if GeoCoords are valid
-    if (!m_map->getSegmentsThatStartWith(start, begin) ||
-        !m_map->getSegmentsThatStartWith(end, last))
+    int first = (graph == nullptr) ? -1 : graph->nodeId(start);
+    int last = (graph == nullptr) ? -1 : graph->nodeId(end);
+    if (first == -1 || last == -1)
         return BAD_COORD;
     
     if (start == end)
@@ -66,77 +53,60 @@ DeliveryResult PointToPointRouterImpl::generatePointToPointRoute(
         return DELIVERY_SUCCESS;
     }
     
-    // Segments to check
-    set<queuedCoord,greaterPriority> openList;
-    set<GeoCoord> closedList;
-            
-    // List of g's for each coordinate
-    map<GeoCoord,double> g;
+    // Intersections to check
+    priority_queue<queuedNode,vector<queuedNode>,greater<queuedNode> > openList;
+    vector<bool> closedList(graph->nodes.size(), false);
     
-    // Map of path
-    map<GeoCoord,StreetSegment> path;
+    // g for each intersection, and the one before it on the best path
+    vector<double> g(graph->nodes.size(), numeric_limits<double>::infinity());
+    vector<int> previous(graph->nodes.size(), -1);
+    vector<int> previousStreet(graph->nodes.size(), -1);
     
-    queuedCoord first(start,0);
-    g[start] = 0;
-    openList.insert(first);
+    const GeoCoord& goal = graph->nodes[last];
+    g[first] = 0;
+    openList.push(queuedNode(distanceEarthMiles(start, goal), first));
     
     // A*
-    while (openList.begin()->coord != end)
+    while (!openList.empty())
     {
-        if (openList.empty())
+        int current = openList.top().second;
+        openList.pop();
+        // Skip entries for intersections already reached more cheaply
+        if (closedList[current])
+            continue;
+        closedList[current] = true;
+        if (current == last)
             break;
-        GeoCoord current = openList.begin()->coord;
-        openList.erase(openList.begin());
-        closedList.insert(current);
-        vector<StreetSegment> segments;
-        m_map->getSegmentsThatStartWith(current, segments);
-        for (int i = 0; i != segments.size(); i++)
+        const GeoCoord& from = graph->nodes[current];
+        for (int i = graph->firstEdge[current]; i != graph->firstEdge[current + 1]; i++)
         {
-            double newg = g[current] + distanceEarthMiles(segments[i].start, segments[i].end);
-            queuedCoord child(segments[i].end,newg + distanceEarthMiles(segments[i].end,end));
-            auto openCheck = openList.find(child);
-            bool openExist = false;
-            if (openCheck != openList.end())
-            {
-                if (g[openCheck->coord] > newg)
-                {
-                    g.erase(openCheck->coord);
-                    openList.erase(openCheck);
-                }
-                else
-                   openExist = true;
-            }
-            auto closedCheck = closedList.find(segments[i].end);
-            bool closedExist = false;
-            if (closedCheck != closedList.end())
-            {
-                if (g[*closedCheck] > newg)
-                {
-                    g.erase(*closedCheck);
-                    closedList.erase(closedCheck);
-                }
-                else
-                    closedExist = true;
-            }
-            if (!openExist && !closedExist)
+            int next = graph->edges[i].to;
+            if (closedList[next])
+                continue;
+            const GeoCoord& to = graph->nodes[next];
+            double newg = g[current] + distanceEarthMiles(from, to);
+            if (newg < g[next])
             {
-                openList.insert(child);
-                g[segments[i].end] = newg;
-                path[child.coord] = segments[i];
+                g[next] = newg;
+                previous[next] = current;
+                previousStreet[next] = graph->edges[i].street;
+                openList.push(queuedNode(newg + distanceEarthMiles(to, goal), next));
             }
         }
     }
             
-    if (openList.empty())
+    if (!closedList[last])
         return NO_ROUTE;
     
-    GeoCoord current = end;
-    while (current != start)
+    list<StreetSegment> newRoute;
+    for (int current = last; current != first; current = previous[current])
     {
-        route.push_front(path[current]);
-        totalDistanceTravelled += distanceEarthMiles(path[current].end, path[current].start);
-        current = path[current].start;
+        const GeoCoord& from = graph->nodes[previous[current]];
+        const GeoCoord& to = graph->nodes[current];
+        newRoute.push_front(StreetSegment(from, to, graph->streets[previousStreet[current]]));
+        totalDistanceTravelled += distanceEarthMiles(from, to);
     }
+    route.swap(newRoute);
     
     return DELIVERY_SUCCESS;
     
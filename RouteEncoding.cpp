@@ -0,0 +1,273 @@
+#include "provided.h"
+#include "RouteEncoding.h"
+#include <string>
+#include <vector>
+#include <list>
+#include <iterator>
+#include <cctype>
+using namespace std;
+
+// Coordinates are stored as fixed point with 7 decimal places, plus the number
+// of decimal places the text had so it can be rebuilt exactly. Text that
+// can't be stored that way (e.g. "34.06253291" or "+1") is stored as is.
+const long long FIXED_SCALE = 10000000;
+const int MAX_DECIMALS = 7;
+// Latitudes and longitudes are within +-180 degrees
+const long long MAX_FIXED = 180 * FIXED_SCALE;
+// Each coordinate starts with a varint of (zigzag(delta) << 4) | kind, where
+// kind is the number of decimal places, or RAW_TEXT followed by the text
+const int KIND_BITS = 4;
+const int RAW_TEXT = 15;
+
+static void putVarint(unsigned long long value, string& out)
+{
+    while (value >= 0x80)
+    {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+static bool getVarint(const string& in, size_t& pos, unsigned long long& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (pos >= in.size())
+            return false;
+        unsigned char byte = in[pos++];
+        value |= static_cast<unsigned long long>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+static unsigned long long zigzag(long long value)
+{
+    return (static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63);
+}
+
+static long long unzigzag(unsigned long long value)
+{
+    return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+}
+
+static string fixedToText(long long fixed, int decimals)
+{
+    string text;
+    if (fixed < 0)
+    {
+        text += '-';
+        fixed = -fixed;
+    }
+    text += to_string(fixed / FIXED_SCALE);
+    if (decimals > 0)
+    {
+        string fraction = to_string(fixed % FIXED_SCALE);
+        fraction.insert(0, MAX_DECIMALS - fraction.size(), '0');
+        text += '.';
+        text += fraction.substr(0, decimals);
+    }
+    return text;
+}
+
+static bool textToFixed(const string& text, long long& fixed, int& decimals)
+{
+    size_t pos = 0;
+    bool negative = false;
+    if (pos < text.size() && text[pos] == '-')
+    {
+        negative = true;
+        pos++;
+    }
+    long long whole = 0;
+    size_t digits = 0;
+    for (; pos < text.size() && isdigit(static_cast<unsigned char>(text[pos])); pos++, digits++)
+    {
+        whole = whole * 10 + (text[pos] - '0');
+        if (whole > 180)
+            return false;
+    }
+    if (digits == 0)
+        return false;
+    long long fraction = 0;
+    decimals = 0;
+    if (pos < text.size() && text[pos] == '.')
+    {
+        for (pos++; pos < text.size() && isdigit(static_cast<unsigned char>(text[pos])); pos++)
+        {
+            if (decimals == MAX_DECIMALS)
+                return false;
+            fraction = fraction * 10 + (text[pos] - '0');
+            decimals++;
+        }
+    }
+    for (int i = decimals; i < MAX_DECIMALS; i++)
+        fraction *= 10;
+    fixed = whole * FIXED_SCALE + fraction;
+    if (fixed > MAX_FIXED)
+        return false;
+    if (negative)
+        fixed = -fixed;
+    // Only accept text that comes back out unchanged (e.g. no "+1", "-0", "01")
+    return pos == text.size() && fixedToText(fixed, decimals) == text;
+}
+
+static bool putCoord(const string& text, long long& previous, string& out)
+{
+    long long fixed;
+    int decimals;
+    if (!textToFixed(text, fixed, decimals))
+    {
+        // previous stays the same for the next delta
+        putVarint(RAW_TEXT, out);
+        putVarint(text.size(), out);
+        out += text;
+        return true;
+    }
+    putVarint((zigzag(fixed - previous) << KIND_BITS) | decimals, out);
+    previous = fixed;
+    return true;
+}
+
+static bool getCoord(const string& in, size_t& pos, long long& previous, string& text)
+{
+    unsigned long long value;
+    if (!getVarint(in, pos, value))
+        return false;
+    if (value == RAW_TEXT)
+    {
+        unsigned long long length;
+        if (!getVarint(in, pos, length) || length > in.size() - pos)
+            return false;
+        text = in.substr(pos, length);
+        pos += length;
+        return true;
+    }
+    int decimals = value & ((1 << KIND_BITS) - 1);
+    if (decimals > MAX_DECIMALS)
+        return false;
+    // Reject deltas that would leave the coordinate range (or overflow)
+    long long delta = unzigzag(value >> KIND_BITS);
+    if (delta > 2 * MAX_FIXED || delta < -2 * MAX_FIXED)
+        return false;
+    long long fixed = previous + delta;
+    if (fixed > MAX_FIXED || fixed < -MAX_FIXED)
+        return false;
+    previous = fixed;
+    text = fixedToText(previous, decimals);
+    return true;
+}
+
+bool encodeRoute(const list<StreetSegment>& route, string& encoded)
+{
+    vector<string> names;
+    vector<pair<int,int> > runs;
+    string points;
+    long long lat = 0, lon = 0;
+
+    for (auto it = route.begin(); it != route.end(); it++)
+    {
+        if (it == route.begin())
+        {
+            // First point of the route
+            if (!putCoord(it->start.latitudeText, lat, points) ||
+                !putCoord(it->start.longitudeText, lon, points))
+                return false;
+        }
+        else if (it->start != prev(it)->end)
+            return false;
+        if (!putCoord(it->end.latitudeText, lat, points) ||
+            !putCoord(it->end.longitudeText, lon, points))
+            return false;
+
+        // Group consecutive segments on the same street
+        if (!runs.empty() && names[runs.back().first] == it->name)
+        {
+            runs.back().second++;
+            continue;
+        }
+        int index = 0;
+        while (index != names.size() && names[index] != it->name)
+            index++;
+        if (index == names.size())
+            names.push_back(it->name);
+        runs.push_back(pair<int,int>(index, 1));
+    }
+
+    string out;
+    putVarint(names.size(), out);
+    for (int i = 0; i != names.size(); i++)
+    {
+        putVarint(names[i].size(), out);
+        out += names[i];
+    }
+    putVarint(runs.size(), out);
+    for (int i = 0; i != runs.size(); i++)
+    {
+        putVarint(runs[i].first, out);
+        putVarint(runs[i].second, out);
+    }
+    out += points;
+    encoded.swap(out);
+    return true;
+}
+
+bool decodeRoute(const string& encoded, list<StreetSegment>& route)
+{
+    size_t pos = 0;
+    unsigned long long count, length;
+
+    // Street names
+    if (!getVarint(encoded, pos, count) || count > encoded.size())
+        return false;
+    vector<string> names;
+    for (unsigned long long i = 0; i != count; i++)
+    {
+        if (!getVarint(encoded, pos, length) || length > encoded.size() - pos)
+            return false;
+        names.push_back(encoded.substr(pos, length));
+        pos += length;
+    }
+
+    // Street runs
+    if (!getVarint(encoded, pos, count) || count > encoded.size())
+        return false;
+    vector<pair<unsigned long long,unsigned long long> > runs;
+    for (unsigned long long i = 0; i != count; i++)
+    {
+        unsigned long long index;
+        if (!getVarint(encoded, pos, index) || !getVarint(encoded, pos, length) || index >= names.size())
+            return false;
+        runs.push_back(pair<unsigned long long,unsigned long long>(index, length));
+    }
+
+    // Points
+    list<StreetSegment> newRoute;
+    long long lat = 0, lon = 0;
+    string latText, lonText;
+    GeoCoord current;
+    if (!runs.empty())
+    {
+        if (!getCoord(encoded, pos, lat, latText) || !getCoord(encoded, pos, lon, lonText))
+            return false;
+        current = GeoCoord(latText, lonText);
+    }
+    for (int i = 0; i != runs.size(); i++)
+    {
+        for (unsigned long long j = 0; j != runs[i].second; j++)
+        {
+            if (!getCoord(encoded, pos, lat, latText) || !getCoord(encoded, pos, lon, lonText))
+                return false;
+            GeoCoord next(latText, lonText);
+            newRoute.push_back(StreetSegment(current, next, names[runs[i].first]));
+            current = next;
+        }
+    }
+    if (pos != encoded.size())
+        return false;
+    route.swap(newRoute);
+    return true;
+}
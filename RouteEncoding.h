@@ -0,0 +1,28 @@
+#ifndef ROUTE_ENCODING
+#define ROUTE_ENCODING
+
+#include "provided.h"
+#include <string>
+#include <vector>
+#include <list>
+
+// RouteEncoding.h
+
+// Packs a route (a list of StreetSegments where each segment starts where the
+// previous one ended) into a compact byte string:
+//   - a table of the distinct street names on the route
+//   - runs of (street name index, number of segments) for consecutive segments
+//     on the same street
+//   - the route's points as delta-encoded, varint-packed fixed point
+//     coordinates, which keep the exact latitude/longitude text of the map
+//     (text that doesn't fit, such as more than 7 decimal places, is stored
+//     as is)
+// Returns false only if the route isn't contiguous.
+bool encodeRoute(const std::list<StreetSegment>& route, std::string& encoded);
+
+// Rebuilds the route from a string produced by encodeRoute.
+// Returns false if the string is malformed, including any coordinate outside
+// +-180 degrees.
+bool decodeRoute(const std::string& encoded, std::list<StreetSegment>& route);
+
+#endif
@@ -1,11 +1,16 @@
 #include "provided.h"
 #include "ExpandableHashMap.h"
+#include "StreetMapOrdering.h"
+#include "StreetMapGraph.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <vector>
 #include <functional>
+#include <algorithm>
+#include <map>
+#include <mutex>
 using namespace std;
 
 unsigned int hasher(const GeoCoord& g)
@@ -13,6 +18,11 @@ unsigned int hasher(const GeoCoord& g)
     return std::hash<string>()(g.latitudeText + g.longitudeText);
 }
 
+unsigned int hasher(const string& s)
+{
+    return std::hash<string>()(s);
+}
+
 class StreetMapImpl
 {
   public:
@@ -20,9 +30,20 @@ class StreetMapImpl
     ~StreetMapImpl();
     bool load(string mapFile);
     bool getSegmentsThatStartWith(const GeoCoord& gc, vector<StreetSegment>& segs) const;
+    const StreetMapGraph& graph() const;
+    void setOrdering(NodeOrdering ordering);
   private:
-    void associate(GeoCoord coord1, GeoCoord coord2, string street);
-    ExpandableHashMap<GeoCoord,vector<StreetSegment> > m_map;
+    typedef StreetMapGraph::Edge Edge;
+    void unpack(vector<vector<Edge> >& edges) const;
+    int nodeId(const GeoCoord& coord, vector<vector<Edge> >& edges);
+    int streetId(const string& street);
+    void associate(int from, int to, int street, vector<vector<Edge> >& edges);
+    void order(NodeOrdering ordering, const vector<vector<Edge> >& edges, vector<int>& newId) const;
+    void layout(const vector<int>& newId, const vector<vector<Edge> >& edges);
+    
+    StreetMapGraph m_graph;
+    ExpandableHashMap<string,int> m_streetIds;
+    NodeOrdering m_ordering = HILBERT_ORDER;
 };
 
 StreetMapImpl::StreetMapImpl()
@@ -41,13 +62,17 @@ bool StreetMapImpl::load(string mapFile)
         cout << "Cannot open map data file!" << endl;
         return false;
     }
-    string line, street;
+    
+    // Unpack anything already loaded so new segments join the same graph
+    vector<vector<Edge> > edges;
+    unpack(edges);
+    
+    string line;
     int segments;
     while (getline(inf,line))
     {
-        vector<StreetSegment> segs;
         // Street name
-        street = line;
+        int id = streetId(line);
         // Number of segment pairs
         getline(inf,line);
         istringstream num(line);
@@ -60,48 +85,217 @@ bool StreetMapImpl::load(string mapFile)
             istringstream seg(line);
             // Segments
             seg >> lat1 >> long1;
-            GeoCoord coord1(lat1, long1);
+            int node1 = nodeId(GeoCoord(lat1, long1), edges);
             seg >> lat2 >> long2;
-            GeoCoord coord2(lat2, long2);
+            int node2 = nodeId(GeoCoord(lat2, long2), edges);
             // Normal segment
-            associate(coord1,coord2,street);
+            associate(node1,node2,id,edges);
             // Reverse segment
-            associate(coord2,coord1,street);
+            associate(node2,node1,id,edges);
         }
     }
+    
+    // Renumber intersections and lay out their segments contiguously
+    vector<int> newId;
+    order(m_ordering, edges, newId);
+    layout(newId, edges);
     return true;
 }
 
 bool StreetMapImpl::getSegmentsThatStartWith(const GeoCoord& gc, vector<StreetSegment>& segs) const
 {
-    const vector<StreetSegment>* search = m_map.find(gc);
+    const int* search = m_graph.ids.find(gc);
     if (search == nullptr)
         return false;
-    segs = *search;
+    const GeoCoord& start = m_graph.nodes[*search];
+    segs.clear();
+    for (int i = m_graph.firstEdge[*search]; i != m_graph.firstEdge[*search + 1]; i++)
+        segs.push_back(StreetSegment(start, m_graph.nodes[m_graph.edges[i].to], m_graph.streets[m_graph.edges[i].street]));
     return true;
 }
 
-void StreetMapImpl::associate(GeoCoord coord1, GeoCoord coord2, string street)
+const StreetMapGraph& StreetMapImpl::graph() const
+{
+    return m_graph;
+}
+
+void StreetMapImpl::setOrdering(NodeOrdering ordering)
+{
+    m_ordering = ordering;
+    if (m_graph.nodes.empty())
+        return;
+    
+    // Lay out what's already loaded again
+    vector<vector<Edge> > edges;
+    unpack(edges);
+    vector<int> newId;
+    order(m_ordering, edges, newId);
+    layout(newId, edges);
+}
+
+void StreetMapImpl::unpack(vector<vector<Edge> >& edges) const
+{
+    edges = vector<vector<Edge> >(m_graph.nodes.size());
+    for (int i = 0; i != m_graph.nodes.size(); i++)
+        edges[i].assign(m_graph.edges.begin() + m_graph.firstEdge[i], m_graph.edges.begin() + m_graph.firstEdge[i + 1]);
+}
+
+int StreetMapImpl::nodeId(const GeoCoord& coord, vector<vector<Edge> >& edges)
+{
+    const int* exist = m_graph.ids.find(coord);
+    if (exist != nullptr)
+        return *exist;
+    int id = m_graph.nodes.size();
+    m_graph.ids.associate(coord, id);
+    m_graph.nodes.push_back(coord);
+    edges.push_back(vector<Edge>());
+    return id;
+}
+
+int StreetMapImpl::streetId(const string& street)
 {
-    StreetSegment seg(coord1,coord2,street);
-    vector<StreetSegment>* exist = m_map.find(coord1);
-    if (exist == nullptr)
+    const int* exist = m_streetIds.find(street);
+    if (exist != nullptr)
+        return *exist;
+    int id = m_graph.streets.size();
+    m_streetIds.associate(street, id);
+    m_graph.streets.push_back(street);
+    return id;
+}
+
+void StreetMapImpl::associate(int from, int to, int street, vector<vector<Edge> >& edges)
+{
+    for (auto it = edges[from].begin(); it != edges[from].end(); it++)
     {
-        vector<StreetSegment> segs;
-        segs.push_back(seg);
-        m_map.associate(coord1,segs);
+        if (it->to == to && it->street == street)
+            return;
     }
-    else
+    edges[from].push_back(Edge(to, street));
+}
+
+// Distance along a Hilbert curve filling an n by n grid (n a power of 2)
+static unsigned long long hilbertIndex(unsigned int n, unsigned int x, unsigned int y)
+{
+    unsigned long long d = 0;
+    for (unsigned int s = n / 2; s > 0; s /= 2)
+    {
+        unsigned int rx = (x & s) > 0;
+        unsigned int ry = (y & s) > 0;
+        d += static_cast<unsigned long long>(s) * s * ((3 * rx) ^ ry);
+        // Rotate the quadrant
+        if (ry == 0)
+        {
+            if (rx == 1)
+            {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            swap(x, y);
+        }
+    }
+    return d;
+}
+
+void StreetMapImpl::order(NodeOrdering ordering, const vector<vector<Edge> >& edges, vector<int>& newId) const
+{
+    int n = m_graph.nodes.size();
+    vector<int> sequence;
+    sequence.reserve(n);
+    
+    switch (ordering)
     {
-        auto it = exist->begin();
-        for (; it != exist->end(); it++)
+        case LOAD_ORDER:
+            for (int i = 0; i != n; i++)
+                sequence.push_back(i);
+            break;
+        case HILBERT_ORDER:
         {
-            if (*it == seg)
+            if (n == 0)
                 break;
+            double minLat = m_graph.nodes[0].latitude, maxLat = minLat;
+            double minLong = m_graph.nodes[0].longitude, maxLong = minLong;
+            for (int i = 0; i != n; i++)
+            {
+                minLat = min(minLat, m_graph.nodes[i].latitude);
+                maxLat = max(maxLat, m_graph.nodes[i].latitude);
+                minLong = min(minLong, m_graph.nodes[i].longitude);
+                maxLong = max(maxLong, m_graph.nodes[i].longitude);
+            }
+            const unsigned int grid = 1 << 16;
+            double latScale = maxLat > minLat ? (grid - 1) / (maxLat - minLat) : 0;
+            double longScale = maxLong > minLong ? (grid - 1) / (maxLong - minLong) : 0;
+            vector<pair<unsigned long long,int> > keys;
+            keys.reserve(n);
+            for (int i = 0; i != n; i++)
+            {
+                unsigned int x = (m_graph.nodes[i].longitude - minLong) * longScale;
+                unsigned int y = (m_graph.nodes[i].latitude - minLat) * latScale;
+                keys.push_back(pair<unsigned long long,int>(hilbertIndex(grid, x, y), i));
+            }
+            sort(keys.begin(), keys.end());
+            for (int i = 0; i != n; i++)
+                sequence.push_back(keys[i].second);
+            break;
+        }
+        case BFS_ORDER:
+        {
+            vector<bool> visited(n, false);
+            for (int root = 0; root != n; root++)
+            {
+                if (visited[root])
+                    continue;
+                // Each component is appended in breadth-first order
+                int head = sequence.size();
+                visited[root] = true;
+                sequence.push_back(root);
+                for (; head != sequence.size(); head++)
+                {
+                    const vector<Edge>& out = edges[sequence[head]];
+                    for (int i = 0; i != out.size(); i++)
+                    {
+                        if (!visited[out[i].to])
+                        {
+                            visited[out[i].to] = true;
+                            sequence.push_back(out[i].to);
+                        }
+                    }
+                }
+            }
+            break;
         }
-        if (it == exist->end())
-            exist->push_back(seg);
     }
+    
+    newId = vector<int>(n);
+    for (int i = 0; i != n; i++)
+        newId[sequence[i]] = i;
+}
+
+void StreetMapImpl::layout(const vector<int>& newId, const vector<vector<Edge> >& edges)
+{
+    int n = m_graph.nodes.size();
+    vector<GeoCoord> nodes(n);
+    vector<int> oldId(n);
+    for (int i = 0; i != n; i++)
+    {
+        nodes[newId[i]] = m_graph.nodes[i];
+        oldId[newId[i]] = i;
+        m_graph.ids.associate(m_graph.nodes[i], newId[i]);
+    }
+    m_graph.nodes.swap(nodes);
+    
+    vector<int> firstEdge;
+    vector<Edge> allEdges;
+    firstEdge.reserve(n + 1);
+    for (int i = 0; i != n; i++)
+    {
+        firstEdge.push_back(allEdges.size());
+        const vector<Edge>& out = edges[oldId[i]];
+        for (int j = 0; j != out.size(); j++)
+            allEdges.push_back(Edge(newId[out[j].to], out[j].street));
+    }
+    firstEdge.push_back(allEdges.size());
+    m_graph.firstEdge.swap(firstEdge);
+    m_graph.edges.swap(allEdges);
 }
 
 //******************** StreetMap functions ************************************
@@ -109,13 +303,50 @@ void StreetMapImpl::associate(GeoCoord coord1, GeoCoord coord2, string street)
 // These functions simply delegate to StreetMapImpl's functions.
 // You probably don't want to change any of this code.
 
+// StreetMaps that exist -> their Impl, so streetMapGraph and
+// setStreetMapNodeOrdering can find them. StreetMaps may be created and
+// destroyed on any thread, so all access goes through streetMapsMutex.
+static mutex streetMapsMutex;
+
+static map<const StreetMap*, StreetMapImpl*>& streetMaps()
+{
+    static map<const StreetMap*, StreetMapImpl*> maps;
+    return maps;
+}
+
+static StreetMapImpl* findStreetMap(const StreetMap* sm)
+{
+    lock_guard<mutex> lock(streetMapsMutex);
+    auto it = streetMaps().find(sm);
+    return it == streetMaps().end() ? nullptr : it->second;
+}
+
+const StreetMapGraph* streetMapGraph(const StreetMap* sm)
+{
+    StreetMapImpl* impl = findStreetMap(sm);
+    return impl == nullptr ? nullptr : &impl->graph();
+}
+
+void setStreetMapNodeOrdering(StreetMap* sm, NodeOrdering ordering)
+{
+    StreetMapImpl* impl = findStreetMap(sm);
+    if (impl != nullptr)
+        impl->setOrdering(ordering);
+}
+
 StreetMap::StreetMap()
 {
     m_impl = new StreetMapImpl;
+    lock_guard<mutex> lock(streetMapsMutex);
+    streetMaps()[this] = m_impl;
 }
 
 StreetMap::~StreetMap()
 {
+    {
+        lock_guard<mutex> lock(streetMapsMutex);
+        streetMaps().erase(this);
+    }
     delete m_impl;
 }
 
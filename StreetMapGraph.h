@@ -0,0 +1,46 @@
+#ifndef STREETMAP_GRAPH
+#define STREETMAP_GRAPH
+
+#include "provided.h"
+#include "ExpandableHashMap.h"
+#include <string>
+#include <vector>
+
+// StreetMapGraph.h
+
+// A loaded StreetMap's intersections and the segments leaving them, laid out
+// contiguously in the order chosen with setStreetMapNodeOrdering. Searches
+// can work on intersection indexes instead of GeoCoord strings.
+struct StreetMapGraph
+{
+    struct Edge
+    {
+        Edge(int to, int street) : to(to), street(street) {}
+        int to;      // index into nodes
+        int street;  // index into streets
+    };
+
+      // Index of the intersection at coord, or -1 if it isn't on the map
+    int nodeId(const GeoCoord& coord) const
+    {
+        const int* id = ids.find(coord);
+        return id == nullptr ? -1 : *id;
+    }
+
+    ExpandableHashMap<GeoCoord,int> ids;
+    std::vector<std::string> streets;
+
+    // Segments leaving nodes[i] are edges[firstEdge[i]] up to edges[firstEdge[i+1]]
+    std::vector<GeoCoord> nodes;
+    std::vector<int> firstEdge = std::vector<int>(1, 0);
+    std::vector<Edge> edges;
+};
+
+// The graph of a StreetMap, for code that has only the StreetMap pointer, or
+// nullptr if sm isn't a live StreetMap. Safe to call from any thread. The
+// graph stays at the same address for the StreetMap's lifetime, so look it
+// up once (e.g. when constructing a router) rather than on every query.
+// Defined in StreetMap.cpp.
+const StreetMapGraph* streetMapGraph(const StreetMap* sm);
+
+#endif
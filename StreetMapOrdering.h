@@ -0,0 +1,24 @@
+#ifndef STREETMAP_ORDERING
+#define STREETMAP_ORDERING
+
+// StreetMapOrdering.h
+
+// How StreetMap lays out intersections (and the segments leaving them) in
+// memory after a map is loaded. Intersections that are close together on the
+// map end up close together in memory, so routing searches touch fewer
+// cache lines.
+enum NodeOrdering
+{
+    LOAD_ORDER,     // order they first appear in the map data file
+    HILBERT_ORDER,  // along a Hilbert curve over their coordinates
+    BFS_ORDER       // breadth-first over the street graph
+};
+
+class StreetMap;
+
+// Selects the ordering for one StreetMap (the default is HILBERT_ORDER). It
+// is used by the map's later loads, and a map that's already loaded is laid
+// out again right away. Like load, don't call it while the map is in use.
+void setStreetMapNodeOrdering(StreetMap* sm, NodeOrdering ordering);
+
+#endif
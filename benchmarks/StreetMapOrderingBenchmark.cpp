@@ -0,0 +1,111 @@
+// StreetMapOrderingBenchmark.cpp
+//
+// Times map loading and point-to-point routes for each intersection ordering.
+// Build from this directory, next to the project's provided.h:
+//   g++ -std=c++11 -O2 -I.. StreetMapOrderingBenchmark.cpp ../StreetMap.cpp ../PointToPointRouter.cpp -o bench
+// Run:
+//   ./bench mapdata.txt [all|load|hilbert|bfs] [routes] [rounds]
+// To count cache misses for one ordering, run it alone under perf:
+//   perf stat -e cache-references,cache-misses ./bench mapdata.txt hilbert
+
+#include "provided.h"
+#include "StreetMapOrdering.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <list>
+#include <chrono>
+#include <cstdlib>
+using namespace std;
+
+// Every intersection named in the map file, with repeats
+static bool readCoords(string mapFile, vector<GeoCoord>& coords)
+{
+    ifstream inf(mapFile);
+    if (!inf)
+        return false;
+    string line;
+    while (getline(inf, line))
+    {
+        getline(inf, line);
+        int segments = atoi(line.c_str());
+        for (int i = 0; i < segments; i++)
+        {
+            getline(inf, line);
+            istringstream seg(line);
+            string lat1, long1, lat2, long2;
+            seg >> lat1 >> long1 >> lat2 >> long2;
+            coords.push_back(GeoCoord(lat1, long1));
+            coords.push_back(GeoCoord(lat2, long2));
+        }
+    }
+    return !coords.empty();
+}
+
+static double secondsSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static void run(string mapFile, NodeOrdering ordering, string name, const vector<GeoCoord>& coords, int routes, int rounds)
+{
+    auto start = chrono::steady_clock::now();
+    StreetMap sm;
+    setStreetMapNodeOrdering(&sm, ordering);
+    sm.load(mapFile);
+    double loadTime = secondsSince(start);
+
+    PointToPointRouter router(&sm);
+    double best = 0;
+    double distance = 0;
+    for (int round = 0; round < rounds; round++)
+    {
+        // Same pseudo-random pairs for every ordering and round
+        srand(1);
+        distance = 0;
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < routes; i++)
+        {
+            const GeoCoord& from = coords[rand() % coords.size()];
+            const GeoCoord& to = coords[rand() % coords.size()];
+            list<StreetSegment> route;
+            router.generatePointToPointRoute(from, to, route, distance);
+        }
+        double time = secondsSince(start);
+        if (round == 0 || time < best)
+            best = time;
+    }
+    cout << name << ": load " << loadTime << "s, "
+         << best * 1000 / routes << " ms/route (best of " << rounds << "), "
+         << "total distance " << distance << " miles" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        cout << "Usage: " << argv[0] << " mapfile [all|load|hilbert|bfs] [routes] [rounds]" << endl;
+        return 1;
+    }
+    string mapFile = argv[1];
+    string which = argc > 2 ? argv[2] : "all";
+    int routes = argc > 3 ? atoi(argv[3]) : 100;
+    int rounds = argc > 4 ? atoi(argv[4]) : 3;
+
+    vector<GeoCoord> coords;
+    if (!readCoords(mapFile, coords))
+    {
+        cout << "Cannot read map data file!" << endl;
+        return 1;
+    }
+
+    if (which == "all" || which == "load")
+        run(mapFile, LOAD_ORDER, "load order", coords, routes, rounds);
+    if (which == "all" || which == "hilbert")
+        run(mapFile, HILBERT_ORDER, "hilbert", coords, routes, rounds);
+    if (which == "all" || which == "bfs")
+        run(mapFile, BFS_ORDER, "bfs", coords, routes, rounds);
+    return 0;
+}
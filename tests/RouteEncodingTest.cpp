@@ -0,0 +1,114 @@
+// RouteEncodingTest.cpp
+//
+// Round-trip and malformed-input checks for encodeRoute/decodeRoute.
+// Build from this directory, next to the project's provided.h:
+//   g++ -std=c++11 -I.. RouteEncodingTest.cpp ../RouteEncoding.cpp -o test
+// Prints "Passed all tests" on success; a failed assert aborts.
+
+#include "provided.h"
+#include "RouteEncoding.h"
+#include <iostream>
+#include <string>
+#include <list>
+#include <cassert>
+using namespace std;
+
+static string varint(unsigned long long value)
+{
+    string out;
+    while (value >= 0x80)
+    {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+    return out;
+}
+
+// One street ("A"), one segment, then the given point tokens
+static string onePointRoute(const string& points)
+{
+    return varint(1) + varint(1) + "A" + varint(1) + varint(0) + varint(1) + points;
+}
+
+static void testRoundTrip()
+{
+    GeoCoord a("34.0625329", "-118.4470263");
+    GeoCoord b("34.0632405", "-118.4470467");
+    GeoCoord c("34.064", "-118.45");
+    GeoCoord d("-0.5", "7");
+    GeoCoord e("-89.9999999", "179.9999999");
+    list<StreetSegment> route;
+    route.push_back(StreetSegment(a, b, "Broxton Avenue"));
+    route.push_back(StreetSegment(b, c, "Broxton Avenue"));
+    route.push_back(StreetSegment(c, d, "Weyburn Avenue"));
+    route.push_back(StreetSegment(d, e, "Broxton Avenue"));
+    route.push_back(StreetSegment(e, a, ""));
+    // Text that doesn't fit the fixed point form is kept as is
+    GeoCoord f("34.06253291", "+118.4");
+    GeoCoord g("34.0", "-0");
+    route.push_back(StreetSegment(a, f, "Raw"));
+    route.push_back(StreetSegment(f, g, "Raw"));
+    route.push_back(StreetSegment(g, b, "Raw"));
+
+    string encoded;
+    assert(encodeRoute(route, encoded));
+    list<StreetSegment> decoded;
+    assert(decodeRoute(encoded, decoded));
+    assert(decoded == route);
+
+    // Empty route
+    list<StreetSegment> empty;
+    assert(encodeRoute(empty, encoded));
+    assert(decodeRoute(encoded, decoded));
+    assert(decoded.empty());
+
+    // Not contiguous
+    list<StreetSegment> broken;
+    broken.push_back(StreetSegment(a, b, "A"));
+    broken.push_back(StreetSegment(c, d, "A"));
+    assert(!encodeRoute(broken, encoded));
+}
+
+static void testMalformed()
+{
+    list<StreetSegment> route;
+    route.push_back(StreetSegment(GeoCoord("1", "2"), GeoCoord("3", "4"), "A"));
+    string good;
+    assert(encodeRoute(route, good));
+
+    list<StreetSegment> decoded = route;
+    // Truncated at every length, and trailing garbage
+    for (size_t i = 0; i < good.size(); i++)
+        assert(!decodeRoute(good.substr(0, i), decoded));
+    assert(!decodeRoute(good + "x", decoded));
+    // Failed decodes leave the route alone
+    assert(decoded == route);
+
+    // Street index out of range, name longer than the string
+    assert(!decodeRoute(varint(1) + varint(1) + "A" + varint(1) + varint(1) + varint(1), decoded));
+    assert(!decodeRoute(varint(1) + varint(100) + "A", decoded));
+    // Varint that never ends
+    assert(!decodeRoute(string(20, '\xff'), decoded));
+
+    // More than 7 decimal places, and raw text longer than the string
+    assert(!decodeRoute(onePointRoute(varint(8) + varint(0) + varint(0) + varint(0)), decoded));
+    assert(!decodeRoute(onePointRoute(varint(15) + varint(100) + "1" + varint(0) + varint(0) + varint(0)), decoded));
+
+    // Coordinates pushed out of range by large deltas, and deltas big enough
+    // to overflow if they were added blindly
+    unsigned long long limit = 180ULL * 10000000;
+    string outOfRange = varint(((2 * limit) << 4) | 7);
+    assert(!decodeRoute(onePointRoute(outOfRange + varint(0) + outOfRange + varint(0)), decoded));
+    string huge = varint(0xFFFFFFFFFFFFFFF0ULL);
+    assert(!decodeRoute(onePointRoute(huge + varint(0) + huge + varint(0)), decoded));
+    assert(!decodeRoute(onePointRoute(varint(0) + varint(0) + huge + varint(0)), decoded));
+    assert(decoded == route);
+}
+
+int main()
+{
+    testRoundTrip();
+    testMalformed();
+    cout << "Passed all tests" << endl;
+}